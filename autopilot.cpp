@@ -0,0 +1,132 @@
+#include "autopilot.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simd.h"
+
+void InterceptBatch::resize(size_t n) {
+    size_t padded = (n + 3) & ~(size_t)3;
+    x.resize(padded);
+    y.resize(padded);
+    speedX.resize(padded);
+    speedY.resize(padded);
+    radius.resize(padded);
+    hitX.resize(padded);
+    hitTime.resize(padded);
+    count = n;
+    for (size_t i = n; i < padded; i++) setIdle(i);
+}
+
+void InterceptBatch::set(size_t i, Scalar bx, Scalar by, Scalar vx, Scalar vy, Scalar r) {
+    x[i]      = bx;
+    y[i]      = by;
+    speedX[i] = vx;
+    speedY[i] = vy;
+    radius[i] = r;
+}
+
+void InterceptBatch::setIdle(size_t i) {
+    // no vertical speed: the solver reports it as never arriving
+    set(i, 0, 0, 0, 0, 1);
+}
+
+#if defined(PONG_FIXED_POINT)
+// Same closed form as the float version below, in Q16.16 raw values.
+// Intermediates are int64 so the products and the unfolded distance can
+// not overflow. SSE2/NEON have no integer divide, so this is a plain
+// per-ball loop; it only uses integer ops, so no flag can change it.
+void predictIntercepts(InterceptBatch &batch, Scalar fieldWidth, Scalar paddleY, Scalar timeScale) {
+    const int64_t one   = Fixed::ONE;
+    const int64_t never = scalarMax().raw;
+
+    size_t padded = batch.x.size();
+    for (size_t i = 0; i < padded; i++) {
+        int64_t x  = batch.x[i].raw;
+        int64_t y  = batch.y[i].raw;
+        int64_t vx = ((int64_t)batch.speedX[i].raw * timeScale.raw) >> Fixed::FRAC_BITS;
+        int64_t vy = ((int64_t)batch.speedY[i].raw * timeScale.raw) >> Fixed::FRAC_BITS;
+        int64_t r  = batch.radius[i].raw;
+
+        // Vertical: reach paddleY - r, via the top wall when going up
+        int64_t targetY = paddleY.raw - r;
+        int64_t dist    = (vy > 0) ? targetY - y : (y - r) + (targetY - r);
+        int64_t speed   = std::abs(vy);
+        bool    arrives = speed > 0 && dist >= 0;
+        int64_t t       = arrives ? std::min(dist * one / speed, never) : never;
+
+        // Horizontal: fold the unfolded position back into [r, width - r]
+        int64_t span   = fieldWidth.raw - 2 * r;
+        int64_t period = std::max<int64_t>(2 * span, 1);
+        int64_t u      = x + ((vx * t) >> Fixed::FRAC_BITS) - r;
+        int64_t p      = u % period;
+        if (p < 0) p += period;
+        int64_t hitX   = r + span - std::abs(p - span);
+
+        batch.hitX[i]    = Fixed::fromRaw((int32_t)hitX);
+        batch.hitTime[i] = Fixed::fromRaw((int32_t)t);
+    }
+}
+#else
+void predictIntercepts(InterceptBatch &batch, Scalar fieldWidth, Scalar paddleY, Scalar timeScale) {
+    const vfloat scale = vdup(timeScale);
+    const vfloat width = vdup(fieldWidth);
+    const vfloat line  = vdup(paddleY);
+    const vfloat zero  = vdup(0.0f);
+    const vfloat two   = vdup(2.0f);
+    const vfloat never = vdup(INFINITY);
+    const vfloat tiny  = vdup(1e-6f);
+
+    size_t padded = batch.x.size();
+    for (size_t i = 0; i < padded; i += LANES) {
+        vfloat x  = vload(&batch.x[i]);
+        vfloat y  = vload(&batch.y[i]);
+        vfloat vx = vmul(vload(&batch.speedX[i]), scale);
+        vfloat vy = vmul(vload(&batch.speedY[i]), scale);
+        vfloat r  = vload(&batch.radius[i]);
+
+        // Vertical: the centre has to reach paddleY - r. A ball going up
+        // first travels to the top wall (centre at r) and comes back down.
+        vfloat targetY  = vsub(line, r);
+        vmask  goingDown = vgt(vy, zero);
+        vfloat distDown  = vsub(targetY, y);
+        vfloat distUp    = vadd(vsub(y, r), vsub(targetY, r));
+        vfloat dist      = vselect(goingDown, distDown, distUp);
+        vfloat speed     = vabs(vy);
+        vfloat t         = vdiv(dist, vmax(speed, tiny));
+        // still, or already past the paddle line
+        vmask  arrives   = vand(vgt(speed, zero), vge(dist, zero));
+
+        // Horizontal: unfold the side-wall bounces. The centre moves
+        // between r and fieldWidth - r; in unfolded space that is a
+        // triangle wave with period 2 * span.
+        vfloat span   = vsub(width, vmul(two, r));
+        vfloat period = vmul(two, span);
+        vfloat u      = vsub(vadd(x, vmul(vx, t)), r);
+        vfloat p      = vsub(u, vmul(period, vfloor(vdiv(u, period))));
+        vfloat hitX   = vadd(r, vsub(span, vabs(vsub(p, span))));
+
+        vstore(&batch.hitX[i], hitX);
+        vstore(&batch.hitTime[i], vselect(arrives, t, never));
+    }
+}
+#endif
+
+int mostUrgentIntercept(const InterceptBatch &batch) {
+    int best = -1;
+    Scalar bestTime = scalarMax();
+    for (size_t i = 0; i < batch.size(); i++) {
+        if (batch.hitTime[i] < bestTime) {
+            bestTime = batch.hitTime[i];
+            best = (int)i;
+        }
+    }
+    return best;
+}
+
+int steerTowards(Scalar paddleX, Scalar paddleWidth, Scalar targetX, Scalar deadZone) {
+    Scalar center = paddleX + paddleWidth / 2;
+    if (targetX < center - deadZone) return -1;
+    if (targetX > center + deadZone) return 1;
+    return 0;
+}
@@ -0,0 +1,50 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include <cstddef>
+#include <vector>
+
+#include "scalar.h"
+
+// Trajectory prediction for an AI paddle. For every ball it works out,
+// in closed form, when the ball's bottom reaches the paddle line and
+// where it will be then. Bounces off the top and side walls are folded
+// in analytically instead of stepping the simulation. The float solver
+// runs LANES balls at a time over structure-of-arrays input (see simd.h).
+// The answer is exact for continuous motion; the tick simulation clamps
+// balls to the wall on contact, so it can land up to one step away per
+// bounce.
+//
+// Everything here is in Scalar and has no Match dependency, so the
+// network bot can run it on snapshot data too. The chosen input moves the
+// paddle, so the prediction is part of the simulation: with
+// PONG_FIXED_POINT it runs in Q16.16 integer math like the rest of the
+// match, and autopilot matches stay bit-identical across builds.
+
+// Balls to predict, plus the results. Arrays are padded to a multiple
+// of four; padding lanes never reach the paddle.
+struct InterceptBatch {
+    std::vector<Scalar> x, y, speedX, speedY, radius;
+    std::vector<Scalar> hitX;     // ball centre x when it reaches the paddle
+    std::vector<Scalar> hitTime;  // ticks until then, scalarMax() if never
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    void resize(size_t n);
+    void set(size_t i, Scalar bx, Scalar by, Scalar vx, Scalar vy, Scalar r);
+    // Keeps the index but never reaches the paddle (inactive balls)
+    void setIdle(size_t i);
+};
+
+// Fills hitX/hitTime for a field fieldWidth wide with the paddle top at
+// paddleY; timeScale is the current ball time scale (slow motion)
+void predictIntercepts(InterceptBatch &batch, Scalar fieldWidth, Scalar paddleY, Scalar timeScale);
+
+// Index of the ball that reaches the paddle first, -1 if none is coming
+int mostUrgentIntercept(const InterceptBatch &batch);
+
+// -1/0/+1 paddle input that moves the paddle centre towards targetX;
+// deadZone stops it from jittering around the target
+int steerTowards(Scalar paddleX, Scalar paddleWidth, Scalar targetX, Scalar deadZone);
+
+#endif
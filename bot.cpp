@@ -0,0 +1,314 @@
+// Load-testing bot for server.cpp.
+//
+// Opens one TCP connection (one match) per bot and plays every match from
+// a single epoll loop: each snapshot is answered with at most one input
+// that steers the paddle to where the most urgent ball will come down
+// (the autopilot trajectory solver). Finished matches are restarted so
+// the server stays busy.
+//
+// Build: g++ -O2 -o pong_bot bot.cpp autopilot.cpp
+// Run:   ./pong_bot [--host 127.0.0.1] [--port 7777] [--bots 100] [--udp] [--seconds 0]
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "autopilot.h"
+#include "net.h"
+
+enum BotEventKind : uint32_t {
+    BOT_TCP,
+    BOT_UDP
+};
+
+struct Bot {
+    int tcpFd = -1;
+    int udpFd = -1;
+    bool welcomed = false;
+    uint32_t matchId = 0;
+    uint32_t token   = 0;
+    uint32_t lastTick = 0;
+    std::vector<char> in;
+    // latest snapshot values we report on
+    int score = 0;
+    int level = 1;
+    bool gameOver = false;
+};
+
+std::vector<Bot> bots;
+int epollFd = -1;
+sockaddr_in serverAddr = {};
+bool useUdp = false;
+
+uint64_t snapshotsReceived = 0;
+uint64_t inputsSent        = 0;
+uint64_t gamesFinished     = 0;
+int      botsConnected     = 0;
+
+volatile sig_atomic_t running = 1;
+
+void handleSignal(int) {
+    running = 0;
+}
+
+void dropBot(uint32_t id) {
+    Bot &b = bots[id];
+    if (b.tcpFd < 0) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, b.tcpFd, nullptr);
+    close(b.tcpFd);
+    if (b.udpFd >= 0) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, b.udpFd, nullptr);
+        close(b.udpFd);
+    }
+    b.tcpFd = b.udpFd = -1;
+    botsConnected--;
+}
+
+void sendInput(uint32_t id, int move, bool restart) {
+    Bot &b = bots[id];
+    MsgInput in = {};
+    in.h.type  = MSG_INPUT;
+    in.h.size  = sizeof(in);
+    in.matchId = b.matchId;
+    in.token   = b.token;
+    in.move    = (int8_t)move;
+    in.restart = restart ? 1 : 0;
+    // Inputs are tiny; if the socket is full we simply skip this one
+    if (b.udpFd >= 0) send(b.udpFd, &in, sizeof(in), 0);
+    else send(b.tcpFd, &in, sizeof(in), MSG_NOSIGNAL | MSG_DONTWAIT);
+    inputsSent++;
+}
+
+// Heads for the ball that reaches the paddle first. Snapshots carry raw
+// ball speeds; the time scale only stretches arrival times, which does
+// not change where balls land or which one lands first.
+int chooseMove(const MsgSnapshot &s, const NetBall *balls) {
+    static InterceptBatch batch;
+    batch.resize(s.numBalls);
+    for (int i = 0; i < s.numBalls; i++) {
+        batch.set(i, Scalar(balls[i].x), Scalar(balls[i].y), Scalar(balls[i].speedX), Scalar(balls[i].speedY), Scalar(balls[i].size));
+    }
+    predictIntercepts(batch, WINDOW_WIDTH, Scalar(s.paddleY), 1);
+    int ball = mostUrgentIntercept(batch);
+    Scalar targetX = (ball >= 0) ? batch.hitX[ball] : Scalar(WINDOW_WIDTH / 2);
+    return steerTowards(Scalar(s.paddleX), Scalar(s.paddleWidth), targetX, 10);
+}
+
+void onSnapshot(uint32_t id, const char *data, size_t size) {
+    if (size < sizeof(MsgSnapshot)) return;
+    MsgSnapshot s;
+    memcpy(&s, data, sizeof(s));
+    size_t expected = sizeof(MsgSnapshot) + s.numBalls * sizeof(NetBall) + s.numPowerUps * sizeof(NetPowerUp);
+    if (size != expected) return;
+
+    Bot &b = bots[id];
+    // UDP may reorder; never act on stale state
+    if (s.tick < b.lastTick) return;
+    b.lastTick = s.tick;
+    snapshotsReceived++;
+
+    if (s.gameOver) {
+        if (!b.gameOver) gamesFinished++;
+        b.gameOver = true;
+        sendInput(id, 0, true);
+        return;
+    }
+    b.gameOver = false;
+    b.score = s.score;
+    b.level = s.level;
+
+    std::vector<NetBall> balls(s.numBalls);
+    memcpy(balls.data(), data + sizeof(MsgSnapshot), s.numBalls * sizeof(NetBall));
+    int move = chooseMove(s, balls.data());
+    if (move != 0) sendInput(id, move, false);
+}
+
+void onWelcome(uint32_t id, const MsgWelcome &w) {
+    Bot &b = bots[id];
+    b.welcomed = true;
+    b.matchId  = w.matchId;
+    b.token    = w.token;
+    if (!useUdp) return;
+
+    b.udpFd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (b.udpFd < 0 || connect(b.udpFd, (sockaddr *)&serverAddr, sizeof(serverAddr)) < 0) {
+        perror("udp connect");
+        return;
+    }
+    epoll_event ev = {};
+    ev.events   = EPOLLIN;
+    ev.data.u64 = ((uint64_t)BOT_UDP << 32) | id;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, b.udpFd, &ev);
+    // any valid datagram switches our snapshots over to UDP
+    sendInput(id, 0, false);
+}
+
+void readTcp(uint32_t id) {
+    Bot &b = bots[id];
+    char buf[16384];
+    while (true) {
+        ssize_t n = recv(b.tcpFd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            b.in.insert(b.in.end(), buf, buf + n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        dropBot(id);
+        return;
+    }
+
+    size_t pos = 0;
+    while (b.in.size() - pos >= sizeof(MsgHeader)) {
+        MsgHeader h;
+        memcpy(&h, b.in.data() + pos, sizeof(h));
+        if (h.size < sizeof(MsgHeader)) {
+            dropBot(id);
+            return;
+        }
+        if (b.in.size() - pos < h.size) break;
+        const char *msg = b.in.data() + pos;
+        if (h.type == MSG_WELCOME && h.size == sizeof(MsgWelcome)) {
+            MsgWelcome w;
+            memcpy(&w, msg, sizeof(w));
+            onWelcome(id, w);
+        } else if (h.type == MSG_SNAPSHOT && b.welcomed) {
+            onSnapshot(id, msg, h.size);
+        }
+        if (bots[id].tcpFd < 0) return;
+        pos += h.size;
+    }
+    b.in.erase(b.in.begin(), b.in.begin() + pos);
+}
+
+void readUdp(uint32_t id) {
+    static char buf[MAX_SNAPSHOT_SIZE];
+    while (bots[id].udpFd >= 0) {
+        ssize_t n = recv(bots[id].udpFd, buf, sizeof(buf), 0);
+        if (n <= 0) return;
+        MsgHeader h;
+        if ((size_t)n < sizeof(h)) continue;
+        memcpy(&h, buf, sizeof(h));
+        if (h.type == MSG_SNAPSHOT && h.size == n) onSnapshot(id, buf, n);
+    }
+}
+
+bool connectBot(uint32_t id) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (sockaddr *)&serverAddr, sizeof(serverAddr)) < 0) {
+        perror("connect");
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    bots[id].tcpFd = fd;
+    epoll_event ev = {};
+    ev.events   = EPOLLIN;
+    ev.data.u64 = ((uint64_t)BOT_TCP << 32) | id;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    botsConnected++;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string host = "127.0.0.1";
+    uint16_t port = DEFAULT_PORT;
+    int numBots = 100;
+    int seconds = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--host" && i + 1 < argc) {
+            host = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            port = (uint16_t)atoi(argv[++i]);
+        } else if (arg == "--bots" && i + 1 < argc) {
+            numBots = atoi(argv[++i]);
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        } else if (arg == "--udp") {
+            useUdp = true;
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--host IP] [--port N] [--bots N] [--udp] [--seconds N]\n";
+            return 1;
+        }
+    }
+
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port   = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &serverAddr.sin_addr) != 1) {
+        std::cout << "Bad host address: " << host << std::endl;
+        return 1;
+    }
+    signal(SIGINT,  handleSignal);
+    signal(SIGTERM, handleSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    bots.resize(numBots);
+    for (int i = 0; i < numBots; i++) {
+        if (!connectBot(i)) break;
+    }
+    std::cout << botsConnected << " bots connected to " << host << ":" << port
+              << (useUdp ? " (udp snapshots)" : " (tcp snapshots)") << std::endl;
+
+    auto startTime  = std::chrono::steady_clock::now();
+    auto lastReport = startTime;
+    uint64_t lastSnapshots = 0;
+
+    epoll_event events[256];
+    while (running && botsConnected > 0) {
+        int n = epoll_wait(epollFd, events, 256, 250);
+        if (n < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            BotEventKind kind = (BotEventKind)(events[i].data.u64 >> 32);
+            uint32_t     id   = (uint32_t)events[i].data.u64;
+            if (bots[id].tcpFd < 0) continue;
+            if (kind == BOT_TCP) readTcp(id);
+            else readUdp(id);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastReport >= std::chrono::seconds(1)) {
+            double dt = std::chrono::duration<double>(now - lastReport).count();
+            long long scoreSum = 0;
+            int maxLevel = 0;
+            for (auto &b : bots) {
+                if (b.tcpFd < 0) continue;
+                scoreSum += b.score;
+                maxLevel = std::max(maxLevel, b.level);
+            }
+            std::cout << botsConnected << " bots, "
+                      << (int)((snapshotsReceived - lastSnapshots) / dt) << " snapshots/s, "
+                      << "avg score " << (botsConnected ? scoreSum / botsConnected : 0) << ", "
+                      << "max level " << maxLevel << ", "
+                      << gamesFinished << " games over" << std::endl;
+            lastSnapshots = snapshotsReceived;
+            lastReport = now;
+        }
+        if (seconds > 0 && now - startTime >= std::chrono::seconds(seconds)) break;
+    }
+
+    for (uint32_t id = 0; id < bots.size(); id++) dropBot(id);
+    std::cout << "Done: " << snapshotsReceived << " snapshots, " << inputsSent << " inputs sent\n";
+    return 0;
+}
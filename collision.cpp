@@ -0,0 +1,125 @@
+#include "collision.h"
+
+#include <algorithm>
+
+#include "simd.h"
+
+// Boxes are tested LANES at a time (see simd.h). With PONG_FIXED_POINT
+// the lanes are int32 Q16.16 values and the comparisons integer compares.
+#if defined(PONG_FIXED_POINT)
+typedef vint vscalar;
+static inline vscalar vloadScalar(const Scalar *p) { return vload((const int32_t *)p); }
+static inline vscalar vdupScalar(Scalar s)         { return vdup(s.raw); }
+#else
+typedef vfloat vscalar;
+static inline vscalar vloadScalar(const Scalar *p) { return vload(p); }
+static inline vscalar vdupScalar(Scalar s)         { return vdup(s); }
+#endif
+
+// Boxes per tile in queryBoxes: 4 arrays x 1024 scalars = 16 KB, fits L1
+const size_t TILE_BOXES = 1024;
+
+void BoxList::setEmpty(size_t i) {
+    set(i, scalarMax(), scalarMax(), scalarLowest(), scalarLowest());
+}
+
+void BoxList::resize(size_t n) {
+    size_t padded = (n + 3) & ~(size_t)3;
+    minX.resize(padded);
+    minY.resize(padded);
+    maxX.resize(padded);
+    maxY.resize(padded);
+    count = n;
+    for (size_t i = n; i < padded; i++) setEmpty(i);
+}
+
+// Fills the mask words covering boxes [begin, end); begin is a multiple
+// of 64. test(i) returns the hit bits of boxes i .. i+LANES-1, and the
+// padding lanes past the end are empty boxes, so they never add bits.
+template <typename Test>
+static inline void scanRange(size_t begin, size_t end, uint64_t *mask, Test test) {
+    for (size_t w = begin; w < end; w += 64) {
+        size_t stop = std::min(w + 64, end);
+        uint64_t word = 0;
+        for (size_t i = w; i < stop; i += LANES) {
+            word |= test(i) << (i - w);
+        }
+        mask[w / 64] = word;
+    }
+}
+
+static void boxRange(const AABB &q, const BoxList &boxes, size_t begin, size_t end, uint64_t *mask) {
+    const Scalar *minX = boxes.minX.data();
+    const Scalar *minY = boxes.minY.data();
+    const Scalar *maxX = boxes.maxX.data();
+    const Scalar *maxY = boxes.maxY.data();
+    vscalar qMinX = vdupScalar(q.minX), qMinY = vdupScalar(q.minY);
+    vscalar qMaxX = vdupScalar(q.maxX), qMaxY = vdupScalar(q.maxY);
+    scanRange(begin, end, mask, [&](size_t i) {
+        vmask hit = vand(vand(vge(vloadScalar(maxX + i), qMinX), vge(qMaxX, vloadScalar(minX + i))),
+                         vand(vge(vloadScalar(maxY + i), qMinY), vge(qMaxY, vloadScalar(minY + i))));
+        return vbits(hit);
+    });
+}
+
+void queryBox(const AABB &q, const BoxList &boxes, uint64_t *mask) {
+    boxRange(q, boxes, 0, boxes.size(), mask);
+}
+
+void queryCircle(Scalar cx, Scalar cy, Scalar radius, const BoxList &boxes, uint64_t *mask) {
+    const Scalar *minX = boxes.minX.data();
+    const Scalar *minY = boxes.minY.data();
+    const Scalar *maxX = boxes.maxX.data();
+    const Scalar *maxY = boxes.maxY.data();
+#if defined(PONG_FIXED_POINT)
+    // Squared distances overflow Q16.16, so do them exactly in 64 bits.
+    // Still branch-free per lane; the compiler is free to vectorize it.
+    uint64_t r2 = (uint64_t)((int64_t)radius.raw * radius.raw);
+    scanRange(0, boxes.size(), mask, [&](size_t i) {
+        uint64_t bits = 0;
+        for (size_t l = 0; l < LANES; l++) {
+            int64_t dx = std::max<int64_t>(std::max<int64_t>((int64_t)minX[i + l].raw - cx.raw, (int64_t)cx.raw - maxX[i + l].raw), 0);
+            int64_t dy = std::max<int64_t>(std::max<int64_t>((int64_t)minY[i + l].raw - cy.raw, (int64_t)cy.raw - maxY[i + l].raw), 0);
+            // anything past 2^31 is a miss anyway; clamping keeps the
+            // unsigned sum of squares below 2^64
+            dx = std::min<int64_t>(dx, (int64_t)1 << 31);
+            dy = std::min<int64_t>(dy, (int64_t)1 << 31);
+            bits |= (uint64_t)((uint64_t)(dx * dx) + (uint64_t)(dy * dy) <= r2) << l;
+        }
+        return bits;
+    });
+#else
+    vfloat x = vdup(cx), y = vdup(cy);
+    vfloat r2 = vdup(radius * radius);
+    vfloat zero = vdup(0.0f);
+    scanRange(0, boxes.size(), mask, [&](size_t i) {
+        // distance from the centre to the closest point of each box
+        vfloat dx = vmax(vmax(vsub(vload(minX + i), x), vsub(x, vload(maxX + i))), zero);
+        vfloat dy = vmax(vmax(vsub(vload(minY + i), y), vsub(y, vload(maxY + i))), zero);
+        return vbits(vle(vadd(vmul(dx, dx), vmul(dy, dy)), r2));
+    });
+#endif
+}
+
+void queryBoxes(const BoxList &queries, const BoxList &boxes, uint64_t *masks) {
+    size_t words = maskWords(boxes.size());
+    for (size_t tile = 0; tile < boxes.size(); tile += TILE_BOXES) {
+        size_t tileEnd = std::min(tile + TILE_BOXES, boxes.size());
+        for (size_t q = 0; q < queries.size(); q++) {
+            AABB box = { queries.minX[q], queries.minY[q], queries.maxX[q], queries.maxY[q] };
+            boxRange(box, boxes, tile, tileEnd, masks + q * words);
+        }
+    }
+}
+
+size_t maskToIndices(const uint64_t *mask, size_t n, uint32_t *out) {
+    size_t count = 0;
+    for (size_t w = 0; w < maskWords(n); w++) {
+        uint64_t bits = mask[w];
+        while (bits) {
+            out[count++] = (uint32_t)(w * 64 + __builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,70 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "scalar.h"
+
+// Batched overlap queries. Instead of testing one pair of boxes per call,
+// pack the candidates once into a BoxList and test a box (or circle)
+// against all of them in one SIMD loop. Results come back as bitmasks:
+// bit i of the mask is set when box i is hit. Boxes overlap when
+// q.maxX >= minX and maxX >= q.minX (same for y), so touching edges
+// count as a hit. Use these for every overlap test, including new
+// obstacle types, rather than testing pairs one at a time.
+
+struct AABB {
+    Scalar minX, minY;
+    Scalar maxX, maxY;
+};
+
+// Boxes in structure-of-arrays form so the kernels can load four at once.
+// The arrays are padded with empty boxes to a multiple of four, so the
+// kernels never need a scalar tail loop.
+struct BoxList {
+    std::vector<Scalar> minX, minY, maxX, maxY;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+
+    void resize(size_t n);
+
+    void set(size_t i, Scalar x0, Scalar y0, Scalar x1, Scalar y1) {
+        minX[i] = x0;
+        minY[i] = y0;
+        maxX[i] = x1;
+        maxY[i] = y1;
+    }
+
+    // Square around a centre, as balls and power-ups are stored
+    void setCentered(size_t i, Scalar x, Scalar y, Scalar halfSize) {
+        set(i, x - halfSize, y - halfSize, x + halfSize, y + halfSize);
+    }
+
+    // A slot that never hits anything (inactive objects keep their index)
+    void setEmpty(size_t i);
+};
+
+// Number of uint64_t words a mask over n boxes needs
+inline size_t maskWords(size_t n) {
+    return (n + 63) / 64;
+}
+
+inline bool maskTest(const uint64_t *mask, size_t i) {
+    return (mask[i >> 6] >> (i & 63)) & 1;
+}
+
+// mask gets maskWords(boxes.size()) words
+void queryBox(const AABB &q, const BoxList &boxes, uint64_t *mask);
+void queryCircle(Scalar cx, Scalar cy, Scalar radius, const BoxList &boxes, uint64_t *mask);
+
+// Every query box against every box, walked in cache-sized tiles of boxes.
+// masks is queries.size() rows of maskWords(boxes.size()) words each.
+void queryBoxes(const BoxList &queries, const BoxList &boxes, uint64_t *masks);
+
+// Writes the indices of the set bits to out (room for n), returns how many
+size_t maskToIndices(const uint64_t *mask, size_t n, uint32_t *out);
+
+#endif
@@ -0,0 +1,178 @@
+#include "effects.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "game.h"
+
+const EffectDef EFFECT_DEFS[NUM_EFFECT_DEFS] = {
+    // name              kind             magnitude     duration  stacking       maxStacks
+    { "Paddle widened!", FX_PADDLE_SCALE, Scalar(2.5f), 600,      STACK_IGNORE,  1 },  // PU_WIDEN_PADDLE
+    { "Extra life!",     FX_EXTRA_LIFE,   Scalar(1.0f), 0,        STACK_ADD,     0 },  // PU_EXTRA_LIFE
+    { "Multi-ball!",     FX_MULTI_BALL,   Scalar(0.0f), 0,        STACK_ADD,     0 },  // PU_MULTI_BALL
+    { "Slow motion!",    FX_TIME_SCALE,   Scalar(0.5f), 300,      STACK_REFRESH, 1 },  // PU_SLOW_MOTION
+    { "Speed Boost!",    FX_BALL_SPEED,   Scalar(1.0f), 0,        STACK_ADD,     0 }   // PU_SPEED_BOOST
+};
+static_assert(NUM_EFFECT_DEFS == PU_SPEED_BOOST + 1, "EFFECT_DEFS needs one row per PowerUpType");
+
+void resetEffects(Match &m) {
+    EffectState &fx = m.effects;
+    fx.wheel.clear();
+    fx.active.clear();
+    fx.freeActive.clear();
+    for (int d = 0; d < NUM_EFFECT_DEFS; d++) {
+        fx.stacks[d]   = 0;
+        fx.instance[d] = -1;
+    }
+    fx.paddleScale = 1;
+    fx.timeScale   = 1;
+    m.paddleWidth  = m.originalPaddleWidth;
+}
+
+// magnitude^n by repeated squaring, so the cost grows with log(stacks)
+static Scalar stackedMagnitude(Scalar magnitude, uint32_t n) {
+    Scalar result = 1;
+    while (n > 0) {
+        if (n & 1) result *= magnitude;
+        magnitude *= magnitude;
+        n >>= 1;
+    }
+    return result;
+}
+
+// Recombines the timed modifiers; only runs when a stack count changes.
+// One term per def, not per running instance.
+static void refreshModifiers(Match &m) {
+    EffectState &fx = m.effects;
+    Scalar paddle = 1;
+    Scalar time   = 1;
+    for (int d = 0; d < NUM_EFFECT_DEFS; d++) {
+        const EffectDef &def = EFFECT_DEFS[d];
+        if (fx.stacks[d] == 0) continue;
+        if (def.kind == FX_PADDLE_SCALE) paddle *= stackedMagnitude(def.magnitude, fx.stacks[d]);
+        else if (def.kind == FX_TIME_SCALE) time *= stackedMagnitude(def.magnitude, fx.stacks[d]);
+    }
+    fx.paddleScale = paddle;
+    fx.timeScale   = time;
+    m.paddleWidth  = m.originalPaddleWidth * paddle;
+}
+
+static void applyInstant(Match &m, const EffectDef &def) {
+    switch (def.kind) {
+        case FX_EXTRA_LIFE:
+            m.lives += toInt(def.magnitude);
+            if (gameLogging) std::cout << def.name << " Lives: " << m.lives << std::endl;
+            break;
+
+        case FX_MULTI_BALL:
+            // If there's at least one active ball, spawn two more from it
+            for (auto &b : m.balls) {
+                if (b.active) {
+                    // spawn additional balls with slightly varied speeds
+                    Ball b1 = b;
+                    b1.speedX *= Scalar(1.1f);
+                    b1.speedY *= Scalar(-1.2f);
+                    b1.active  = true;
+                    Ball b2 = b;
+                    b2.speedX *= Scalar(-1.2f);
+                    b2.speedY *= Scalar(1.1f);
+                    b2.active  = true;
+                    // push_back may reallocate and invalidate b
+                    m.balls.push_back(b1);
+                    m.balls.push_back(b2);
+                    m.activeBallsCount += 2;
+                    if (gameLogging) std::cout << def.name << "\n";
+                    break;
+                }
+            }
+            break;
+
+        case FX_BALL_SPEED:
+            // Increase speed of all active balls
+            for (auto &b : m.balls) {
+                if (!b.active) continue;
+                if (b.speedX > 0) b.speedX += def.magnitude;
+                else b.speedX -= def.magnitude;
+                if (b.speedY > 0) b.speedY += def.magnitude;
+                else b.speedY -= def.magnitude;
+            }
+            if (gameLogging) std::cout << def.name << "\n";
+            break;
+
+        default:
+            break;
+    }
+}
+
+// The wheel clamps longer delays itself; clamp first so expiresAt
+// matches the tick the timer really fires on
+static uint32_t wheelDelay(uint64_t ticks) {
+    return (uint32_t)std::min<uint64_t>(ticks, TimingWheel::MAX_DELAY);
+}
+
+static void startInstance(Match &m, int d) {
+    EffectState &fx = m.effects;
+    const EffectDef &def = EFFECT_DEFS[d];
+
+    uint32_t slot;
+    if (!fx.freeActive.empty()) {
+        slot = fx.freeActive.back();
+        fx.freeActive.pop_back();
+    } else {
+        slot = (uint32_t)fx.active.size();
+        fx.active.push_back(ActiveEffect());
+    }
+    ActiveEffect &a = fx.active[slot];
+    a.def       = (uint16_t)d;
+    uint32_t delay = wheelDelay(def.duration);
+    a.expiresAt = fx.wheel.now() + delay;
+    a.timer     = fx.wheel.schedule(delay, slot);
+
+    fx.stacks[d]++;
+    if (def.stacking != STACK_ADD) fx.instance[d] = (int32_t)slot;
+    refreshModifiers(m);
+}
+
+void applyEffect(Match &m, int d) {
+    EffectState &fx = m.effects;
+    const EffectDef &def = EFFECT_DEFS[d];
+
+    if (def.duration == 0) {
+        applyInstant(m, def);
+        return;
+    }
+
+    if (def.stacking != STACK_ADD && fx.instance[d] >= 0) {
+        ActiveEffect &a = fx.active[fx.instance[d]];
+        uint32_t remaining = (uint32_t)(a.expiresAt - fx.wheel.now());
+        uint32_t delay;
+        switch (def.stacking) {
+            case STACK_REFRESH: delay = wheelDelay(def.duration);                       break;
+            case STACK_EXTEND:  delay = wheelDelay((uint64_t)remaining + def.duration); break;
+            default:            return;  // STACK_IGNORE
+        }
+        fx.wheel.cancel(a.timer);
+        a.expiresAt = fx.wheel.now() + delay;
+        a.timer     = fx.wheel.schedule(delay, (uint32_t)fx.instance[d]);
+        if (gameLogging) std::cout << def.name << "\n";
+        return;
+    }
+
+    if (def.maxStacks > 0 && fx.stacks[d] >= def.maxStacks) return;
+    startInstance(m, d);
+    if (gameLogging) std::cout << def.name << "\n";
+}
+
+void tickEffects(Match &m) {
+    EffectState &fx = m.effects;
+    bool changed = false;
+    fx.wheel.advance([&](uint32_t slot) {
+        uint16_t d = fx.active[slot].def;
+        fx.active[slot].timer = TimingWheel::INVALID_TIMER;
+        fx.stacks[d]--;
+        if (fx.instance[d] == (int32_t)slot) fx.instance[d] = -1;
+        fx.freeActive.push_back(slot);
+        changed = true;
+    });
+    if (changed) refreshModifiers(m);
+}
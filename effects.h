@@ -0,0 +1,68 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "scalar.h"
+#include "timingwheel.h"
+
+// Power-up effects as data. Each EffectDef row says what the effect does
+// (kind + magnitude), how long it lasts, and what happens when it is
+// picked up again while still running. Expirations live on a timing
+// wheel, so a tick costs O(effects expiring), not O(effects active).
+// Timed effects are match-wide modifiers; nothing in the game targets a
+// single ball yet, so ActiveEffect carries no owner.
+
+enum EffectKind {
+    FX_PADDLE_SCALE,  // timed: paddle width *= magnitude
+    FX_TIME_SCALE,    // timed: ball movement *= magnitude
+    FX_EXTRA_LIFE,    // instant: lives += magnitude
+    FX_MULTI_BALL,    // instant: split the first active ball in three
+    FX_BALL_SPEED     // instant: |speed| += magnitude on every active ball
+};
+
+enum StackRule {
+    STACK_IGNORE,   // a second pick-up does nothing while one is active
+    STACK_REFRESH,  // restart the running instance's full duration
+    STACK_EXTEND,   // add the duration on top of what is left
+    STACK_ADD       // independent instance, magnitudes multiply (up to maxStacks)
+};
+
+struct EffectDef {
+    const char *name;
+    EffectKind  kind;
+    Scalar      magnitude;
+    uint32_t    duration;   // ticks, 0 for instant effects
+    StackRule   stacking;
+    uint16_t    maxStacks;
+};
+
+// One row per PowerUpType, in enum order
+const int NUM_EFFECT_DEFS = 5;
+extern const EffectDef EFFECT_DEFS[NUM_EFFECT_DEFS];
+
+struct ActiveEffect {
+    uint16_t def;
+    uint64_t expiresAt;
+    TimingWheel::TimerId timer = TimingWheel::INVALID_TIMER;  // INVALID_TIMER once expired
+};
+
+// Per-match effect bookkeeping
+struct EffectState {
+    TimingWheel wheel;
+    std::vector<ActiveEffect> active;   // indexed by the wheel payload
+    std::vector<uint32_t>     freeActive;
+    uint16_t stacks[NUM_EFFECT_DEFS]   = {};
+    int32_t  instance[NUM_EFFECT_DEFS]; // running instance for non-STACK_ADD rules, -1 if none
+
+    // Combined modifiers of everything currently running
+    Scalar paddleScale = 1;
+    Scalar timeScale   = 1;
+
+    EffectState() {
+        for (int d = 0; d < NUM_EFFECT_DEFS; d++) instance[d] = -1;
+    }
+};
+
+#endif
@@ -0,0 +1,303 @@
+#include "game.h"
+
+#include <cstddef>
+#include <iostream>
+
+bool gameLogging = true;
+
+// Game Initialization
+void initGame(Match &m, uint32_t seed) {
+    m.rngState = seed;
+    m.balls.clear();
+    // Mark all power-ups inactive
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        m.powerUps[i].active = false;
+    }
+    m.score = 0;
+    m.level = 1;
+    m.lives = 3;
+    m.gameOver = false;
+    m.hitsSinceLastSpeedUp = 0;
+
+    resetEffects(m);
+    spawnInitialBall(m);
+    if (gameLogging) std::cout << "Game initialized!\n";
+}
+
+int matchRand(Match &m) {
+    // LCG, same constants as the classic C library rand()
+    m.rngState = m.rngState * 1103515245u + 12345u;
+    return (int)((m.rngState >> 16) & 0x7fff);
+}
+
+// FNV-1a over the raw bits of everything that affects future ticks
+static void hashBytes(uint32_t &h, const void *data, size_t size) {
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+}
+
+template <typename T>
+static void hashValue(uint32_t &h, const T &v) {
+    hashBytes(h, &v, sizeof(v));
+}
+
+uint32_t matchChecksum(const Match &m) {
+    uint32_t h = 2166136261u;
+    hashValue(h, m.paddleX);
+    hashValue(h, m.paddleWidth);
+    hashValue(h, m.score);
+    hashValue(h, m.level);
+    hashValue(h, m.lives);
+    hashValue(h, m.gameOver);
+    hashValue(h, m.hitsSinceLastSpeedUp);
+    hashValue(h, m.activeBallsCount);
+    hashValue(h, m.rngState);
+    for (const auto &b : m.balls) {
+        if (!b.active) continue;
+        hashValue(h, b.x);
+        hashValue(h, b.y);
+        hashValue(h, b.speedX);
+        hashValue(h, b.speedY);
+        hashValue(h, b.size);
+    }
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        const PowerUp &pu = m.powerUps[i];
+        if (!pu.active) continue;
+        hashValue(h, i);
+        hashValue(h, pu.x);
+        hashValue(h, pu.y);
+        hashValue(h, pu.type);
+    }
+    hashValue(h, m.effects.timeScale);
+    hashBytes(h, m.effects.stacks, sizeof(m.effects.stacks));
+    // time left on every running instance, in slot order
+    for (size_t i = 0; i < m.effects.active.size(); i++) {
+        const ActiveEffect &a = m.effects.active[i];
+        if (a.timer == TimingWheel::INVALID_TIMER) continue;
+        uint32_t remaining = (uint32_t)(a.expiresAt - m.effects.wheel.now());
+        hashValue(h, (uint32_t)i);
+        hashValue(h, a.def);
+        hashValue(h, remaining);
+    }
+    return h;
+}
+
+void restartMatch(Match &m) {
+    initGame(m, matchChecksum(m));
+}
+
+// Spawns a single ball in the middle with random X direction
+void spawnInitialBall(Match &m) {
+    Ball b;
+    b.x = WINDOW_WIDTH / 2;
+    b.y = WINDOW_HEIGHT / 2;
+    b.size = m.defaultBallSize;
+    b.active = true;
+    b.speedX = (matchRand(m) % 2 == 0) ? m.defaultBallSpeed : -m.defaultBallSpeed;
+    b.speedY = -m.defaultBallSpeed;
+    m.balls.push_back(b);
+    m.activeBallsCount = 1;
+}
+
+// When a life is lost,the ball is respawned
+// on the opposite side of the paddle
+void loseLifeAndRespawnBall(Match &m) {
+    m.lives--;
+    if (gameLogging) std::cout << "Lost a life! Lives left: " << m.lives << std::endl;
+    if (m.lives <= 0) {
+        m.gameOver = true;
+        return;
+    }
+
+    for (auto &b : m.balls) {
+        if (b.active) {
+            // We place it near top, e.g. y=60, x ~ paddle center
+            b.x = m.paddleX + m.paddleWidth/2;
+            b.y = 60;
+            // If speedY is currently positive (going up), invert it so it goes down.
+            if (b.speedY > 0) b.speedY = -b.speedY;
+            return;
+        }
+    }
+    spawnInitialBall(m);
+}
+
+// Power-up logic
+void trySpawnPowerUp(Match &m) {
+    // Small chance each frame
+    if (matchRand(m) % 300 == 0) {
+        for (int i = 0; i < MAX_POWERUPS; i++) {
+            if (!m.powerUps[i].active) {
+                m.powerUps[i].active = true;
+                m.powerUps[i].x = matchRand(m) % (WINDOW_WIDTH - 50) + 25;
+                m.powerUps[i].y = matchRand(m) % (WINDOW_HEIGHT - 100) + 25;
+                m.powerUps[i].size = 20;
+                m.powerUps[i].rotationAngle = 0.0f;
+                int t = matchRand(m) % 5;
+                m.powerUps[i].type = (PowerUpType) t;
+                break;
+            }
+        }
+    }
+}
+
+void applyPowerUpEffect(Match &m, PowerUpType type) {
+    applyEffect(m, (int)type);
+}
+
+void packBallBoxes(Match &m) {
+    m.ballBoxes.resize(m.balls.size());
+    for (size_t i = 0; i < m.balls.size(); i++) {
+        const Ball &b = m.balls[i];
+        if (b.active) m.ballBoxes.setCentered(i, b.x, b.y, b.size);
+        else m.ballBoxes.setEmpty(i);
+    }
+}
+
+void updatePowerUps(Match &m) {
+    m.powerUpBoxes.resize(MAX_POWERUPS);
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        PowerUp &pu = m.powerUps[i];
+        if (!pu.active) {
+            m.powerUpBoxes.setEmpty(i);
+            continue;
+        }
+        // spin
+        pu.rotationAngle += 2.0f;
+        m.powerUpBoxes.setCentered(i, pu.x, pu.y, pu.size);
+    }
+
+    // collision with any active ball: every power-up against every ball
+    packBallBoxes(m);
+    size_t words = maskWords(m.balls.size());
+    m.hitMasks.resize(MAX_POWERUPS * words);
+    queryBoxes(m.powerUpBoxes, m.ballBoxes, m.hitMasks.data());
+
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        if (!m.powerUps[i].active) continue;
+        const uint64_t *row = m.hitMasks.data() + i * words;
+        for (size_t w = 0; w < words; w++) {
+            if (row[w] == 0) continue;
+            m.powerUps[i].active = false;
+            applyPowerUpEffect(m, m.powerUps[i].type);
+            break;
+        }
+    }
+
+    // handle durations
+    tickEffects(m);
+}
+
+void updateBalls(Match &m) {
+    Scalar speedFactor = m.effects.timeScale;
+
+    for (auto &b : m.balls) {
+        if (!b.active) continue;
+
+        b.x += b.speedX * speedFactor;
+        b.y += b.speedY * speedFactor;
+
+        // check side walls
+        if (b.x - b.size < 0) {
+            b.x = b.size;
+            b.speedX *= -1;
+        }
+        else if (b.x + b.size > WINDOW_WIDTH) {
+            b.x = WINDOW_WIDTH - b.size;
+            b.speedX *= -1;
+        }
+
+        // top wall
+        if (b.y - b.size < 0) {
+            b.y = b.size;
+            b.speedY *= -1;
+        }
+    }
+
+    // paddle collision: one query against every ball
+    packBallBoxes(m);
+    m.hitMasks.resize(maskWords(m.balls.size()));
+    AABB paddle = { m.paddleX, m.paddleY, m.paddleX + m.paddleWidth, m.paddleY + m.paddleHeight };
+    queryBox(paddle, m.ballBoxes, m.hitMasks.data());
+
+    for (size_t i = 0; i < m.balls.size(); i++) {
+        Ball &b = m.balls[i];
+        if (!b.active) continue;
+
+        if (maskTest(m.hitMasks.data(), i))
+        {
+            b.y = m.paddleY - b.size;  // place above paddle
+            b.speedY *= -1;
+            m.score++;
+            m.hitsSinceLastSpeedUp++;
+            if (m.hitsSinceLastSpeedUp >= 5) {
+                m.hitsSinceLastSpeedUp = 0;
+                m.level++;
+                // speed up all active balls slightly
+                for (auto &bb : m.balls) {
+                    if (!bb.active) continue;
+                    if (bb.speedX > 0) bb.speedX += Scalar(0.5f); else bb.speedX -= Scalar(0.5f);
+                    if (bb.speedY > 0) bb.speedY += Scalar(0.5f); else bb.speedY -= Scalar(0.5f);
+                }
+                if (gameLogging) std::cout << "Level up! " << m.level << std::endl;
+            }
+            if (gameLogging) std::cout << "Score: " << m.score << std::endl;
+        }
+        if (b.y - b.size > WINDOW_HEIGHT) {
+            // ball is lost
+            b.active = false;
+            m.activeBallsCount--;
+            if (m.activeBallsCount <= 0) {
+                // lose a life => spawn from bottom side
+                // (may push_back into m.balls, so b is not used afterwards)
+                loseLifeAndRespawnBall(m);
+                // If lives > 0, we still have 1 active ball now
+                if (!m.gameOver) {
+                    m.activeBallsCount = 1;
+                }
+                break;
+            }
+        }
+    }
+}
+
+void movePaddle(Match &m, int dir) {
+    Scalar moveSpeed = 20;
+    if (dir < 0) {
+        m.paddleX -= moveSpeed;
+        if (m.paddleX < 0) m.paddleX = 0;
+    }
+    else if (dir > 0) {
+        m.paddleX += moveSpeed;
+        if (m.paddleX + m.paddleWidth > WINDOW_WIDTH) {
+            m.paddleX = WINDOW_WIDTH - m.paddleWidth;
+        }
+    }
+}
+
+void stepMatch(Match &m) {
+    if (m.gameOver) return;
+    updateBalls(m);
+    updatePowerUps(m);
+    trySpawnPowerUp(m);
+}
+
+int autopilotInput(Match &m) {
+    InterceptBatch &batch = m.intercepts;
+    batch.resize(m.balls.size());
+    for (size_t i = 0; i < m.balls.size(); i++) {
+        const Ball &b = m.balls[i];
+        if (b.active) batch.set(i, b.x, b.y, b.speedX, b.speedY, b.size);
+        else batch.setIdle(i);
+    }
+    predictIntercepts(batch, WINDOW_WIDTH, m.paddleY, m.effects.timeScale);
+
+    // nothing coming down: wait in the middle
+    int ball = mostUrgentIntercept(batch);
+    Scalar targetX = (ball >= 0) ? batch.hitX[ball] : Scalar(WINDOW_WIDTH / 2);
+    // half a step of slack, so it settles instead of hopping over the target
+    return steerTowards(m.paddleX, m.paddleWidth, targetX, 10);
+}
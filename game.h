@@ -0,0 +1,118 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <cstdint>
+#include <vector>
+
+#include "autopilot.h"
+#include "collision.h"
+#include "effects.h"
+#include "scalar.h"
+
+// Shared simulation for the GLUT client (main.cpp) and the headless
+// server (server.cpp). Nothing in here may depend on GL/GLUT.
+
+const int WINDOW_WIDTH  = 800;
+const int WINDOW_HEIGHT = 600;
+
+//Ball
+struct Ball {
+    Scalar x, y;
+    Scalar speedX, speedY;
+    Scalar size;
+    bool   active;
+};
+
+// Power-ups
+enum PowerUpType {
+    PU_WIDEN_PADDLE,  // Double arrow shape
+    PU_EXTRA_LIFE,    // Heart shape
+    PU_MULTI_BALL,    // Cluster of spheres
+    PU_SLOW_MOTION,   // Hourglass shape
+    PU_SPEED_BOOST    // Lightning shape
+};
+
+struct PowerUp {
+    bool   active;
+    Scalar x, y;
+    Scalar size;
+    PowerUpType type;
+    float  rotationAngle; // for spinning, display only
+};
+
+const int MAX_POWERUPS = 5;
+
+// Everything one game needs to tick. The client owns a single Match,
+// the server owns hundreds of them.
+struct Match {
+    // Paddle
+    Scalar paddleX      = 350;
+    Scalar paddleY      = 580;
+    Scalar paddleWidth  = 100;
+    Scalar paddleHeight = 20;
+    Scalar originalPaddleWidth = 100;
+
+    std::vector<Ball> balls;
+    int    activeBallsCount  = 0;
+    Scalar defaultBallSpeed  = 3;
+    Scalar defaultBallSize   = 15;
+
+    int score = 0;
+    int level = 1;
+    int lives = 3;
+    bool gameOver = false;
+
+    int hitsSinceLastSpeedUp = 0;
+
+    PowerUp powerUps[MAX_POWERUPS] = {};
+    // All randomness of a match comes from here, so a seed plus the
+    // inputs replays it exactly
+    uint32_t rngState = 1;
+    // Timed power-ups; paddleWidth and the ball time scale come from here
+    EffectState effects;
+
+    // Scratch space for the batched collision queries, kept between
+    // ticks so they don't allocate
+    BoxList ballBoxes;      // one per entry of balls, inactive ones empty
+    BoxList powerUpBoxes;   // one per power-up slot
+    std::vector<uint64_t> hitMasks;
+    InterceptBatch intercepts;  // for autopilotInput
+};
+
+// Set to false to silence the per-event console output (the server
+// runs far too many matches for it to be useful).
+extern bool gameLogging;
+
+void initGame(Match &m, uint32_t seed);
+// 0..32767 from the match's own generator
+int matchRand(Match &m);
+// Hash of the simulation state. With PONG_FIXED_POINT two matches fed
+// the same seed and inputs agree on every build and machine.
+uint32_t matchChecksum(const Match &m);
+// Starts a finished match over, seeded from its final checksum, so a
+// whole session (restarts included) follows from the first seed
+void restartMatch(Match &m);
+void spawnInitialBall(Match &m);
+void loseLifeAndRespawnBall(Match &m);
+void trySpawnPowerUp(Match &m);
+void applyPowerUpEffect(Match &m, PowerUpType type);
+// Refreshes m.ballBoxes from the current ball positions
+void packBallBoxes(Match &m);
+void updateBalls(Match &m);
+void updatePowerUps(Match &m);
+// dir < 0 moves left, dir > 0 moves right, one key press worth
+void movePaddle(Match &m, int dir);
+// One fixed-timestep tick of a running match
+void stepMatch(Match &m);
+// AI paddle: the movePaddle() direction that heads for the ball that
+// reaches the paddle first (trajectory solver in autopilot.cpp)
+int autopilotInput(Match &m);
+
+// effects.cpp
+void resetEffects(Match &m);
+// d indexes EFFECT_DEFS (the PowerUpType of the pick-up)
+void applyEffect(Match &m, int d);
+// Advances the effect clock one tick and retires what expires
+void tickEffects(Match &m);
+
+#endif
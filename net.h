@@ -0,0 +1,99 @@
+#ifndef NET_H
+#define NET_H
+
+#include <cstdint>
+
+#include "game.h"
+
+// Wire protocol shared by server.cpp and bot.cpp.
+// Meant for localhost/LAN only: structs are sent packed in host byte
+// order, so server and clients must run on the same kind of machine.
+
+const uint16_t DEFAULT_PORT = 7777;
+const int      TICK_RATE    = 60;   // server ticks per second
+
+enum MsgType : uint8_t {
+    MSG_WELCOME  = 1,  // server -> client (TCP), right after accept
+    MSG_INPUT    = 2,  // client -> server (TCP or UDP)
+    MSG_SNAPSHOT = 3   // server -> client (UDP if the client sent any UDP, else TCP)
+};
+
+#pragma pack(push, 1)
+
+// Every message starts with this; size covers the whole message
+struct MsgHeader {
+    uint8_t  type;
+    uint8_t  pad;
+    uint16_t size;
+};
+
+struct MsgWelcome {
+    MsgHeader h;
+    uint32_t  matchId;
+    uint32_t  token;     // must be echoed in every MsgInput
+    uint16_t  tickRate;
+    uint16_t  pad;
+    uint32_t  seed;      // initGame() seed; restarts use restartMatch()
+};
+
+// The server keeps the latest input per match and applies it once,
+// right before the match's next tick. Snapshots echo which tick that was.
+struct MsgInput {
+    MsgHeader h;
+    uint32_t  matchId;
+    uint32_t  token;
+    int8_t    move;      // -1 left, +1 right, 0 none (one key press worth)
+    uint8_t   restart;   // non-zero restarts a finished match
+    uint16_t  pad;
+};
+
+struct NetBall {
+    float x, y;
+    float speedX, speedY;
+    float size;
+};
+
+struct NetPowerUp {
+    float   x, y;
+    float   size;
+    uint8_t type;
+    uint8_t pad[3];
+};
+
+const uint32_t NO_INPUT_TICK = 0xffffffffu;
+
+// Followed by numBalls NetBall and numPowerUps NetPowerUp.
+// Only active balls and power-ups are sent.
+//
+// Replaying a match: initGame(seed from MsgWelcome), then for every tick
+// t apply the input echoed with inputTick == t (restartMatch() if it asks
+// for a restart and the game is over, else movePaddle()), then
+// stepMatch(). After tick steps matchChecksum() must equal checksum;
+// with PONG_FIXED_POINT that holds across builds and machines. It needs
+// every snapshot: one lost over UDP, or skipped for a slow TCP client,
+// may hide an input.
+struct MsgSnapshot {
+    MsgHeader h;
+    uint32_t  tick;          // ticks this match has run
+    int32_t   score;
+    int32_t   level;
+    int32_t   lives;
+    uint32_t  checksum;      // matchChecksum() after tick steps
+    uint32_t  inputTick;     // latest input was applied before step inputTick, NO_INPUT_TICK if none
+    int8_t    inputMove;
+    uint8_t   inputRestart;
+    uint16_t  pad;
+    float     paddleX, paddleY;
+    float     paddleWidth, paddleHeight;
+    uint8_t   gameOver;
+    uint8_t   numPowerUps;
+    uint16_t  numBalls;
+};
+
+#pragma pack(pop)
+
+// Keeps a snapshot inside one UDP datagram
+const int MAX_SNAPSHOT_BALLS = 1024;
+const int MAX_SNAPSHOT_SIZE  = sizeof(MsgSnapshot) + MAX_SNAPSHOT_BALLS * sizeof(NetBall) + MAX_POWERUPS * sizeof(NetPowerUp);
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef SCALAR_H
+#define SCALAR_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// The number type of the simulation state (positions, speeds, sizes,
+// effect magnitudes). Plain float by default; build with
+// -DPONG_FIXED_POINT to get Q16.16 fixed point instead. Fixed point only
+// uses integer adds, multiplies and shifts, so every compiler, flag set
+// (-ffast-math included) and CPU produces the same bits. That is what
+// lets replays and networked games be checked with matchChecksum().
+//
+// Write constants as Scalar(0.5f) and integers as they are; both work
+// with either type. Use toFloat()/toInt() to leave the simulation
+// (drawing, snapshots).
+
+// Q16.16: range +-32768, resolution 1/65536
+struct Fixed {
+    static const int     FRAC_BITS = 16;
+    static const int32_t ONE = 1 << FRAC_BITS;
+
+    int32_t raw;
+
+    Fixed() = default;
+    // Integers convert exactly, so allow it implicitly
+    constexpr Fixed(int i) : raw(i * ONE) {}
+    // Rounds to nearest. A given float always converts to the same raw value.
+    constexpr explicit Fixed(float f)
+        : raw((int32_t)((double)f * ONE + ((double)f >= 0 ? 0.5 : -0.5))) {}
+
+    static constexpr Fixed fromRaw(int32_t r) {
+        return Fixed(r, RawTag());
+    }
+
+    constexpr Fixed operator-() const { return fromRaw(-raw); }
+    constexpr Fixed operator+(Fixed o) const { return fromRaw(raw + o.raw); }
+    constexpr Fixed operator-(Fixed o) const { return fromRaw(raw - o.raw); }
+    // Products round toward -infinity (arithmetic shift)
+    constexpr Fixed operator*(Fixed o) const {
+        return fromRaw((int32_t)(((int64_t)raw * o.raw) >> FRAC_BITS));
+    }
+    constexpr Fixed operator/(Fixed o) const {
+        return fromRaw((int32_t)(((int64_t)raw * ONE) / o.raw));
+    }
+    // Dividing by a plain integer needs no rescaling
+    constexpr Fixed operator/(int d) const { return fromRaw(raw / d); }
+
+    Fixed &operator+=(Fixed o) { raw += o.raw; return *this; }
+    Fixed &operator-=(Fixed o) { raw -= o.raw; return *this; }
+    Fixed &operator*=(Fixed o) { return *this = *this * o; }
+    Fixed &operator/=(Fixed o) { return *this = *this / o; }
+
+    constexpr bool operator<(Fixed o) const  { return raw <  o.raw; }
+    constexpr bool operator>(Fixed o) const  { return raw >  o.raw; }
+    constexpr bool operator<=(Fixed o) const { return raw <= o.raw; }
+    constexpr bool operator>=(Fixed o) const { return raw >= o.raw; }
+    constexpr bool operator==(Fixed o) const { return raw == o.raw; }
+    constexpr bool operator!=(Fixed o) const { return raw != o.raw; }
+
+private:
+    struct RawTag {};
+    constexpr Fixed(int32_t r, RawTag) : raw(r) {}
+};
+
+// int on the left: 1 - x, 20 * y, WINDOW_WIDTH > b.x ...
+inline constexpr Fixed operator+(int a, Fixed b) { return Fixed(a) + b; }
+inline constexpr Fixed operator-(int a, Fixed b) { return Fixed(a) - b; }
+inline constexpr Fixed operator*(int a, Fixed b) { return Fixed(a) * b; }
+inline constexpr bool  operator<(int a, Fixed b) { return Fixed(a) < b; }
+inline constexpr bool  operator>(int a, Fixed b) { return Fixed(a) > b; }
+
+inline float   toFloat(Fixed f) { return (float)f.raw / Fixed::ONE; }
+inline int     toInt(Fixed f)   { return f.raw / Fixed::ONE; }
+inline float   toFloat(float f) { return f; }
+inline int     toInt(float f)   { return (int)f; }
+
+#ifdef PONG_FIXED_POINT
+typedef Fixed Scalar;
+#else
+typedef float Scalar;
+#endif
+
+// Bigger/smaller than any coordinate, for boxes that must never hit
+inline Scalar scalarMax() {
+#ifdef PONG_FIXED_POINT
+    return Fixed::fromRaw(std::numeric_limits<int32_t>::max());
+#else
+    return INFINITY;
+#endif
+}
+
+inline Scalar scalarLowest() {
+#ifdef PONG_FIXED_POINT
+    return Fixed::fromRaw(std::numeric_limits<int32_t>::min());
+#else
+    return -INFINITY;
+#endif
+}
+
+#endif
@@ -0,0 +1,578 @@
+// Headless multi-match server.
+//
+// One process, one thread: a single epoll loop owns the TCP listener, a
+// UDP socket and a timerfd. Every timer expiry ticks all matches with the
+// same fixed timestep, then sends each client one snapshot for that tick
+// (UDP snapshots go out in sendmmsg batches).
+//
+// Build: g++ -O2 -o pong_server server.cpp game.cpp effects.cpp collision.cpp autopilot.cpp
+//        (add -DPONG_FIXED_POINT for bit-identical fixed-point matches)
+// Run:   ./pong_server [--port 7777] [--max-matches 1024] [--ai-matches 0]
+// Load:  ./pong_bot --bots 500   (see bot.cpp), or --ai-matches N to host
+//        N matches played by the built-in autopilot with no network at all
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "game.h"
+#include "net.h"
+
+// Ticks we are willing to run back to back after a stall
+const int MAX_CATCHUP_TICKS = 5;
+// Stop queueing snapshots for a TCP client that is this far behind
+const size_t MAX_PENDING_OUTPUT = 256 * 1024;
+const int UDP_BATCH = 64;
+
+// epoll_event.data.u64 = (kind << 32) | slot
+enum EventKind : uint32_t {
+    EV_LISTEN,
+    EV_UDP,
+    EV_TIMER,
+    EV_CLIENT
+};
+
+struct Client {
+    int fd = -1;
+    uint32_t token = 0;
+    std::vector<char> in, out;
+    bool waitingWritable = false;
+    bool hasUdp = false;
+    sockaddr_in udpAddr = {};
+};
+
+// One hosted match and the player driving it
+struct Slot {
+    bool   used = false;
+    bool   ai   = false;  // played by the autopilot, no client attached
+    Match  match;
+    uint32_t tick = 0;  // ticks this match has run
+    // Latest input since the last tick, applied once right before the
+    // match steps so paddle speed stays tied to the fixed timestep
+    bool   hasPending     = false;
+    int8_t pendingMove    = 0;
+    bool   pendingRestart = false;
+    // The last input applied, echoed in snapshots for replays
+    uint32_t inputTick    = NO_INPUT_TICK;
+    int8_t   inputMove    = 0;
+    bool     inputRestart = false;
+    Client client;
+};
+
+std::vector<Slot>     slots;
+std::vector<uint32_t> freeSlots;
+// Freed during the current epoll batch. Events already returned for the
+// old fd may still follow, so these only become reusable after the batch.
+std::vector<uint32_t> closedSlots;
+int activeMatches = 0;
+int maxMatches    = 1024;
+
+int epollFd  = -1;
+int listenFd = -1;
+int udpFd    = -1;
+int timerFd  = -1;
+
+uint32_t serverTick = 0;
+std::mt19937 tokenRng;
+
+volatile sig_atomic_t running = 1;
+
+void handleSignal(int) {
+    running = 0;
+}
+
+uint64_t eventData(EventKind kind, uint32_t slot) {
+    return ((uint64_t)kind << 32) | slot;
+}
+
+void closeClient(uint32_t id) {
+    Slot &s = slots[id];
+    if (!s.used || s.ai) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, s.client.fd, nullptr);
+    close(s.client.fd);
+    s = Slot();  // unused, fresh match, no pending input
+    closedSlots.push_back(id);
+    activeMatches--;
+}
+
+// Write as much pending output as the socket takes; returns false if
+// the client had to be dropped
+bool flushClient(uint32_t id) {
+    Client &c = slots[id].client;
+    size_t sent = 0;
+    while (sent < c.out.size()) {
+        ssize_t n = send(c.fd, c.out.data() + sent, c.out.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        closeClient(id);
+        return false;
+    }
+    c.out.erase(c.out.begin(), c.out.begin() + sent);
+
+    bool wantWritable = !c.out.empty();
+    if (wantWritable != c.waitingWritable) {
+        epoll_event ev = {};
+        ev.events   = wantWritable ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        ev.data.u64 = eventData(EV_CLIENT, id);
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+        c.waitingWritable = wantWritable;
+    }
+    return true;
+}
+
+// Latches an input for the next tick; a later move replaces an earlier
+// one, a restart request sticks until it is applied
+void applyInput(uint32_t id, const MsgInput &in) {
+    Slot &s = slots[id];
+    s.hasPending  = true;
+    s.pendingMove = in.move;
+    if (in.restart) s.pendingRestart = true;
+}
+
+void applyPendingInput(Slot &s) {
+    if (!s.hasPending) return;
+    Match &m = s.match;
+    if (s.pendingRestart && m.gameOver) {
+        restartMatch(m);
+    } else if (!m.gameOver) {
+        movePaddle(m, s.pendingMove);
+    }
+    s.inputTick      = s.tick;
+    s.inputMove      = s.pendingMove;
+    s.inputRestart   = s.pendingRestart;
+    s.hasPending     = false;
+    s.pendingMove    = 0;
+    s.pendingRestart = false;
+}
+
+// Looks up the slot an input claims to belong to
+bool validInput(const MsgInput &in) {
+    return in.h.type == MSG_INPUT &&
+           in.matchId < slots.size() &&
+           slots[in.matchId].used &&
+           !slots[in.matchId].ai &&
+           slots[in.matchId].client.token == in.token;
+}
+
+void acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("accept4");
+            return;
+        }
+        if (activeMatches >= maxMatches) {
+            close(fd);
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        uint32_t id;
+        if (!freeSlots.empty()) {
+            id = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            id = (uint32_t)slots.size();
+            slots.emplace_back();
+        }
+        Slot &s = slots[id];
+        s.used = true;
+        s.client.fd    = fd;
+        s.client.token = tokenRng();
+        uint32_t seed  = tokenRng();
+        initGame(s.match, seed);
+        activeMatches++;
+
+        epoll_event ev = {};
+        ev.events   = EPOLLIN;
+        ev.data.u64 = eventData(EV_CLIENT, id);
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+
+        MsgWelcome w = {};
+        w.h.type   = MSG_WELCOME;
+        w.h.size   = sizeof(w);
+        w.matchId  = id;
+        w.token    = s.client.token;
+        w.tickRate = TICK_RATE;
+        w.seed     = seed;
+        const char *p = (const char *)&w;
+        s.client.out.insert(s.client.out.end(), p, p + sizeof(w));
+        flushClient(id);
+    }
+}
+
+void readClient(uint32_t id) {
+    Client &c = slots[id].client;
+    char buf[4096];
+    while (true) {
+        ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            c.in.insert(c.in.end(), buf, buf + n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        // orderly shutdown or hard error
+        closeClient(id);
+        return;
+    }
+
+    size_t pos = 0;
+    while (c.in.size() - pos >= sizeof(MsgHeader)) {
+        MsgHeader h;
+        memcpy(&h, c.in.data() + pos, sizeof(h));
+        if (h.size < sizeof(MsgHeader) || h.size > 1024) {
+            closeClient(id);
+            return;
+        }
+        if (c.in.size() - pos < h.size) break;
+        if (h.type == MSG_INPUT && h.size == sizeof(MsgInput)) {
+            MsgInput in;
+            memcpy(&in, c.in.data() + pos, sizeof(in));
+            if (in.matchId == id && validInput(in)) applyInput(id, in);
+        }
+        pos += h.size;
+    }
+    c.in.erase(c.in.begin(), c.in.begin() + pos);
+}
+
+void readUdp() {
+    MsgInput       msgs[UDP_BATCH];
+    sockaddr_in    addrs[UDP_BATCH];
+    iovec          iovs[UDP_BATCH];
+    mmsghdr        hdrs[UDP_BATCH];
+    while (true) {
+        memset(hdrs, 0, sizeof(hdrs));
+        for (int i = 0; i < UDP_BATCH; i++) {
+            iovs[i].iov_base = &msgs[i];
+            iovs[i].iov_len  = sizeof(MsgInput);
+            hdrs[i].msg_hdr.msg_iov     = &iovs[i];
+            hdrs[i].msg_hdr.msg_iovlen  = 1;
+            hdrs[i].msg_hdr.msg_name    = &addrs[i];
+            hdrs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        }
+        int n = recvmmsg(udpFd, hdrs, UDP_BATCH, 0, nullptr);
+        if (n <= 0) return;
+        for (int i = 0; i < n; i++) {
+            if (hdrs[i].msg_len != sizeof(MsgInput) || !validInput(msgs[i])) continue;
+            Client &c = slots[msgs[i].matchId].client;
+            c.hasUdp  = true;
+            c.udpAddr = addrs[i];
+            applyInput(msgs[i].matchId, msgs[i]);
+        }
+        if (n < UDP_BATCH) return;
+    }
+}
+
+// Appends the snapshot of one match to buf
+void writeSnapshot(const Slot &slot, std::vector<char> &buf) {
+    const Match &m = slot.match;
+    uint16_t numBalls = 0;
+    uint8_t  numPowerUps = 0;
+    for (const auto &b : m.balls) {
+        if (b.active && numBalls < MAX_SNAPSHOT_BALLS) numBalls++;
+    }
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        if (m.powerUps[i].active) numPowerUps++;
+    }
+
+    size_t start = buf.size();
+    size_t size  = sizeof(MsgSnapshot) + numBalls * sizeof(NetBall) + numPowerUps * sizeof(NetPowerUp);
+    buf.resize(start + size);
+    char *p = buf.data() + start;
+
+    MsgSnapshot s = {};
+    s.h.type       = MSG_SNAPSHOT;
+    s.h.size       = (uint16_t)size;
+    s.tick         = slot.tick;
+    s.score        = m.score;
+    s.level        = m.level;
+    s.lives        = m.lives;
+    s.checksum     = matchChecksum(m);
+    s.inputTick    = slot.inputTick;
+    s.inputMove    = slot.inputMove;
+    s.inputRestart = slot.inputRestart;
+    s.paddleX      = toFloat(m.paddleX);
+    s.paddleY      = toFloat(m.paddleY);
+    s.paddleWidth  = toFloat(m.paddleWidth);
+    s.paddleHeight = toFloat(m.paddleHeight);
+    s.gameOver     = m.gameOver;
+    s.numPowerUps  = numPowerUps;
+    s.numBalls     = numBalls;
+    memcpy(p, &s, sizeof(s));
+    p += sizeof(s);
+
+    uint16_t written = 0;
+    for (const auto &b : m.balls) {
+        if (!b.active) continue;
+        if (written++ == numBalls) break;
+        NetBall nb = { toFloat(b.x), toFloat(b.y), toFloat(b.speedX), toFloat(b.speedY), toFloat(b.size) };
+        memcpy(p, &nb, sizeof(nb));
+        p += sizeof(nb);
+    }
+    for (int i = 0; i < MAX_POWERUPS; i++) {
+        const PowerUp &pu = m.powerUps[i];
+        if (!pu.active) continue;
+        NetPowerUp np = { toFloat(pu.x), toFloat(pu.y), toFloat(pu.size), (uint8_t)pu.type, {0, 0, 0} };
+        memcpy(p, &np, sizeof(np));
+        p += sizeof(np);
+    }
+}
+
+// Builds every snapshot for this tick into one buffer, then hands them
+// out: one send per TCP client, sendmmsg batches for UDP clients
+void broadcastSnapshots() {
+    static std::vector<char>     arena;
+    static std::vector<uint32_t> owners;
+    static std::vector<size_t>   offsets;
+    arena.clear();
+    owners.clear();
+    offsets.clear();
+
+    for (uint32_t id = 0; id < slots.size(); id++) {
+        Slot &s = slots[id];
+        if (!s.used || s.ai) continue;
+        if (!s.client.hasUdp && s.client.out.size() > MAX_PENDING_OUTPUT) continue;
+        owners.push_back(id);
+        offsets.push_back(arena.size());
+        writeSnapshot(s, arena);
+    }
+    offsets.push_back(arena.size());
+
+    mmsghdr hdrs[UDP_BATCH];
+    iovec   iovs[UDP_BATCH];
+    int pending = 0;
+    auto sendBatch = [&]() {
+        int done = 0;
+        while (done < pending) {
+            int n = sendmmsg(udpFd, hdrs + done, pending - done, 0);
+            if (n <= 0) break; // socket buffer full: drop the rest of this tick
+            done += n;
+        }
+        pending = 0;
+    };
+
+    for (size_t i = 0; i < owners.size(); i++) {
+        uint32_t id = owners[i];
+        const char *data = arena.data() + offsets[i];
+        size_t size = offsets[i + 1] - offsets[i];
+        Client &c = slots[id].client;
+        if (c.hasUdp) {
+            iovs[pending].iov_base = (void *)data;
+            iovs[pending].iov_len  = size;
+            memset(&hdrs[pending], 0, sizeof(mmsghdr));
+            hdrs[pending].msg_hdr.msg_iov     = &iovs[pending];
+            hdrs[pending].msg_hdr.msg_iovlen  = 1;
+            hdrs[pending].msg_hdr.msg_name    = &c.udpAddr;
+            hdrs[pending].msg_hdr.msg_namelen = sizeof(c.udpAddr);
+            if (++pending == UDP_BATCH) sendBatch();
+        } else {
+            c.out.insert(c.out.end(), data, data + size);
+            flushClient(id);
+        }
+    }
+    if (pending > 0) sendBatch();
+}
+
+// Runs the fixed-timestep scheduler for however many ticks the timer says
+// have elapsed, then sends one batch of snapshots
+void onTimer() {
+    uint64_t expirations = 0;
+    if (read(timerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) return;
+    int ticks = (int)std::min<uint64_t>(expirations, MAX_CATCHUP_TICKS);
+
+    static double   tickTimeTotal = 0.0;
+    static double   tickTimeMax   = 0.0;
+    static uint32_t tickSamples   = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        for (auto &s : slots) {
+            if (!s.used) continue;
+            if (s.ai) {
+                // keep the load constant: finished AI matches start over
+                if (s.match.gameOver) restartMatch(s.match);
+                movePaddle(s.match, autopilotInput(s.match));
+            } else {
+                applyPendingInput(s);
+            }
+            stepMatch(s.match);
+            s.tick++;
+        }
+        serverTick++;
+    }
+    broadcastSnapshots();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    tickTimeTotal += us;
+    tickTimeMax    = std::max(tickTimeMax, us);
+    tickSamples++;
+    if (tickSamples >= (uint32_t)TICK_RATE * 5) {
+        std::cout << "tick " << serverTick << ": " << activeMatches << " matches, "
+                  << "frame avg " << (int)(tickTimeTotal / tickSamples) << " us, "
+                  << "max " << (int)tickTimeMax << " us";
+        if (expirations > (uint64_t)ticks) std::cout << " (dropped " << expirations - ticks << " ticks)";
+        std::cout << std::endl;
+        tickTimeTotal = 0.0;
+        tickTimeMax   = 0.0;
+        tickSamples   = 0;
+    }
+}
+
+bool openSockets(uint16_t port) {
+    sockaddr_in addr = {};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(port);
+    int one = 1;
+
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        perror("tcp socket");
+        return false;
+    }
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(listenFd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenFd, SOMAXCONN) < 0) {
+        perror("tcp listen");
+        return false;
+    }
+
+    udpFd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (udpFd < 0) {
+        perror("udp socket");
+        return false;
+    }
+    int sndbuf = 4 * 1024 * 1024;
+    setsockopt(udpFd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    if (bind(udpFd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("udp bind");
+        return false;
+    }
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    itimerspec spec = {};
+    spec.it_interval.tv_nsec = 1000000000L / TICK_RATE;
+    spec.it_value = spec.it_interval;
+    if (timerFd < 0 || timerfd_settime(timerFd, 0, &spec, nullptr) < 0) {
+        perror("timerfd");
+        return false;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        perror("epoll_create1");
+        return false;
+    }
+    struct { int fd; EventKind kind; } fds[] = {
+        { listenFd, EV_LISTEN }, { udpFd, EV_UDP }, { timerFd, EV_TIMER }
+    };
+    for (auto &f : fds) {
+        epoll_event ev = {};
+        ev.events   = EPOLLIN;
+        ev.data.u64 = eventData(f.kind, 0);
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, f.fd, &ev);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint16_t port = DEFAULT_PORT;
+    int aiMatches = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) {
+            port = (uint16_t)atoi(argv[++i]);
+        } else if (arg == "--max-matches" && i + 1 < argc) {
+            maxMatches = atoi(argv[++i]);
+        } else if (arg == "--ai-matches" && i + 1 < argc) {
+            aiMatches = atoi(argv[++i]);
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--port N] [--max-matches N] [--ai-matches N]\n";
+            return 1;
+        }
+    }
+    if (maxMatches < 1) {
+        std::cout << "--max-matches must be at least 1\n";
+        return 1;
+    }
+
+    tokenRng.seed(std::random_device()());
+    gameLogging = false;
+    signal(SIGINT,  handleSignal);
+    signal(SIGTERM, handleSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (!openSockets(port)) return 1;
+    slots.reserve(maxMatches);
+    for (int i = 0; i < aiMatches && activeMatches < maxMatches; i++) {
+        slots.emplace_back();
+        Slot &s = slots.back();
+        s.used = true;
+        s.ai   = true;
+        initGame(s.match, tokenRng());
+        activeMatches++;
+    }
+    std::cout << "Pong server on port " << port << " (tcp+udp), "
+              << TICK_RATE << " Hz, up to " << maxMatches << " matches";
+    if (aiMatches > 0) std::cout << " (" << activeMatches << " autopilot)";
+    std::cout << std::endl;
+
+    epoll_event events[256];
+    while (running) {
+        int n = epoll_wait(epollFd, events, 256, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            EventKind kind = (EventKind)(events[i].data.u64 >> 32);
+            uint32_t  id   = (uint32_t)events[i].data.u64;
+            switch (kind) {
+                case EV_LISTEN: acceptClients(); break;
+                case EV_UDP:    readUdp();       break;
+                case EV_TIMER:  onTimer();       break;
+                case EV_CLIENT:
+                    if (!slots[id].used) break;
+                    if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                        closeClient(id);
+                        break;
+                    }
+                    if (events[i].events & EPOLLIN) readClient(id);
+                    if (slots[id].used && (events[i].events & EPOLLOUT)) flushClient(id);
+                    break;
+            }
+        }
+        freeSlots.insert(freeSlots.end(), closedSlots.begin(), closedSlots.end());
+        closedSlots.clear();
+    }
+
+    for (uint32_t id = 0; id < slots.size(); id++) closeClient(id);
+    close(timerFd);
+    close(udpFd);
+    close(listenFd);
+    close(epollFd);
+    std::cout << "Server stopped.\n";
+    return 0;
+}
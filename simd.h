@@ -0,0 +1,114 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+
+// The small vector layer the batched kernels (collision.cpp,
+// autopilot.cpp) are written against: four lanes with SSE2 (always there
+// on x86-64) or NEON on AArch64, one lane elsewhere. vfloat holds floats,
+// vint holds int32 (fixed-point) values; both compare into vmask.
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+const size_t LANES = 4;
+typedef __m128  vfloat;
+typedef __m128i vint;
+typedef __m128  vmask;
+
+static inline vfloat vload(const float *p)                   { return _mm_loadu_ps(p); }
+static inline void   vstore(float *p, vfloat a)              { _mm_storeu_ps(p, a); }
+static inline vfloat vdup(float f)                           { return _mm_set1_ps(f); }
+static inline vfloat vadd(vfloat a, vfloat b)                { return _mm_add_ps(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b)                { return _mm_sub_ps(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b)                { return _mm_mul_ps(a, b); }
+static inline vfloat vdiv(vfloat a, vfloat b)                { return _mm_div_ps(a, b); }
+static inline vfloat vmax(vfloat a, vfloat b)                { return _mm_max_ps(a, b); }
+static inline vfloat vabs(vfloat a)                          { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+// SSE2 has no round-down: truncate, then step back where that rounded up
+static inline vfloat vfloor(vfloat a) {
+    vfloat t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+}
+static inline vmask  vge(vfloat a, vfloat b)                 { return _mm_cmpge_ps(a, b); }
+static inline vmask  vgt(vfloat a, vfloat b)                 { return _mm_cmpgt_ps(a, b); }
+static inline vmask  vle(vfloat a, vfloat b)                 { return _mm_cmple_ps(a, b); }
+static inline vfloat vselect(vmask m, vfloat a, vfloat b)    { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+static inline vint   vload(const int32_t *p)                 { return _mm_loadu_si128((const __m128i *)p); }
+static inline vint   vdup(int32_t i)                         { return _mm_set1_epi32(i); }
+// SSE2 only has a signed greater-than: a >= b is !(b > a)
+static inline vmask  vge(vint a, vint b)                     { return _mm_castsi128_ps(_mm_xor_si128(_mm_cmpgt_epi32(b, a), _mm_set1_epi32(-1))); }
+
+static inline vmask  vand(vmask a, vmask b)                  { return _mm_and_ps(a, b); }
+static inline uint64_t vbits(vmask m)                        { return (uint64_t)_mm_movemask_ps(m); }
+
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+
+const size_t LANES = 4;
+typedef float32x4_t vfloat;
+typedef int32x4_t   vint;
+typedef uint32x4_t  vmask;
+
+static inline vfloat vload(const float *p)                   { return vld1q_f32(p); }
+static inline void   vstore(float *p, vfloat a)              { vst1q_f32(p, a); }
+static inline vfloat vdup(float f)                           { return vdupq_n_f32(f); }
+static inline vfloat vadd(vfloat a, vfloat b)                { return vaddq_f32(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b)                { return vsubq_f32(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b)                { return vmulq_f32(a, b); }
+static inline vfloat vdiv(vfloat a, vfloat b)                { return vdivq_f32(a, b); }
+static inline vfloat vmax(vfloat a, vfloat b)                { return vmaxq_f32(a, b); }
+static inline vfloat vabs(vfloat a)                          { return vabsq_f32(a); }
+static inline vfloat vfloor(vfloat a)                        { return vrndmq_f32(a); }
+static inline vmask  vge(vfloat a, vfloat b)                 { return vcgeq_f32(a, b); }
+static inline vmask  vgt(vfloat a, vfloat b)                 { return vcgtq_f32(a, b); }
+static inline vmask  vle(vfloat a, vfloat b)                 { return vcleq_f32(a, b); }
+static inline vfloat vselect(vmask m, vfloat a, vfloat b)    { return vbslq_f32(m, a, b); }
+
+static inline vint   vload(const int32_t *p)                 { return vld1q_s32(p); }
+static inline vint   vdup(int32_t i)                         { return vdupq_n_s32(i); }
+static inline vmask  vge(vint a, vint b)                     { return vcgeq_s32(a, b); }
+
+static inline vmask  vand(vmask a, vmask b)                  { return vandq_u32(a, b); }
+static inline uint64_t vbits(vmask m) {
+    const uint32_t weights[4] = { 1, 2, 4, 8 };
+    return vaddvq_u32(vandq_u32(m, vld1q_u32(weights)));
+}
+
+#else
+
+const size_t LANES = 1;
+typedef float   vfloat;
+typedef int32_t vint;
+typedef bool    vmask;
+
+static inline vfloat vload(const float *p)                   { return *p; }
+static inline void   vstore(float *p, vfloat a)              { *p = a; }
+static inline vfloat vdup(float f)                           { return f; }
+static inline vfloat vadd(vfloat a, vfloat b)                { return a + b; }
+static inline vfloat vsub(vfloat a, vfloat b)                { return a - b; }
+static inline vfloat vmul(vfloat a, vfloat b)                { return a * b; }
+static inline vfloat vdiv(vfloat a, vfloat b)                { return a / b; }
+static inline vfloat vmax(vfloat a, vfloat b)                { return std::max(a, b); }
+static inline vfloat vabs(vfloat a)                          { return std::fabs(a); }
+static inline vfloat vfloor(vfloat a)                        { return std::floor(a); }
+static inline vmask  vge(vfloat a, vfloat b)                 { return a >= b; }
+static inline vmask  vgt(vfloat a, vfloat b)                 { return a > b; }
+static inline vmask  vle(vfloat a, vfloat b)                 { return a <= b; }
+static inline vfloat vselect(vmask m, vfloat a, vfloat b)    { return m ? a : b; }
+
+static inline vint   vload(const int32_t *p)                 { return *p; }
+static inline vint   vdup(int32_t i)                         { return i; }
+static inline vmask  vge(vint a, vint b)                     { return a >= b; }
+
+static inline vmask  vand(vmask a, vmask b)                  { return a && b; }
+static inline uint64_t vbits(vmask m)                        { return m ? 1 : 0; }
+
+#endif
+
+#endif
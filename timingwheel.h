@@ -0,0 +1,157 @@
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timing wheel counted in simulation ticks.
+//
+// Four levels of 64 slots cover 64^4 ticks (about 3 days at 60 Hz).
+// Level 0 holds timers due within 64 ticks, one slot per tick. A slot on
+// a higher level holds 64^level ticks' worth of timers and is cascaded
+// down once the lower level wraps around to it. schedule() and cancel()
+// are O(1), and advance() only touches the timers that expire or cascade,
+// never the timers that are still waiting.
+class TimingWheel {
+public:
+    typedef uint64_t TimerId;   // generation << 32 | node index
+    static const TimerId INVALID_TIMER = ~(TimerId)0;
+
+    TimingWheel() { clear(); }
+
+    void clear() {
+        for (int l = 0; l < LEVELS; l++) {
+            for (int s = 0; s < SLOTS; s++) heads[l][s] = NIL;
+        }
+        nodes.clear();
+        freeNodes = NIL;
+        current = 0;
+    }
+
+    uint64_t now() const { return current; }
+
+    // Fires payload after delay ticks (at least one)
+    TimerId schedule(uint32_t delay, uint32_t payload) {
+        if (delay == 0) delay = 1;
+        if (delay > MAX_DELAY) delay = MAX_DELAY;
+
+        uint32_t index;
+        if (freeNodes != NIL) {
+            index = freeNodes;
+            freeNodes = nodes[index].next;
+        } else {
+            index = (uint32_t)nodes.size();
+            nodes.push_back(Node());
+        }
+        Node &n = nodes[index];
+        n.expires = current + delay;
+        n.payload = payload;
+        n.linked  = true;
+        link(index);
+        return ((TimerId)n.generation << 32) | index;
+    }
+
+    // Returns false if the timer already fired or was cancelled
+    bool cancel(TimerId id) {
+        uint32_t index = (uint32_t)id;
+        if (id == INVALID_TIMER || index >= nodes.size()) return false;
+        Node &n = nodes[index];
+        if (!n.linked || n.generation != (uint32_t)(id >> 32)) return false;
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    // Moves time forward one tick and calls onExpire(payload) for every
+    // timer due now. onExpire may schedule or cancel timers.
+    template <typename F>
+    void advance(F onExpire) {
+        current++;
+        for (int l = 1; l < LEVELS; l++) {
+            if (((current >> ((l - 1) * BITS)) & MASK) != 0) break;
+            cascade(l, (current >> (l * BITS)) & MASK);
+        }
+
+        // Pop one at a time so onExpire can cancel timers due this same
+        // tick; anything it schedules lands in a later slot
+        uint32_t *head = &heads[0][current & MASK];
+        while (*head != NIL) {
+            uint32_t index   = *head;
+            uint32_t payload = nodes[index].payload;
+            unlink(index);
+            release(index);
+            onExpire(payload);
+        }
+    }
+
+private:
+    static const int      BITS   = 6;
+    static const int      SLOTS  = 1 << BITS;
+    static const uint64_t MASK   = SLOTS - 1;
+    static const int      LEVELS = 4;
+    static const uint32_t NIL = ~0u;
+
+public:
+    // Longest delay schedule() accepts; longer ones are clamped to it
+    static const uint32_t MAX_DELAY = (1u << (BITS * LEVELS)) - 1;
+
+private:
+
+    struct Node {
+        uint64_t expires    = 0;
+        uint32_t payload    = 0;
+        uint32_t next       = NIL;
+        uint32_t prev       = NIL;
+        uint32_t generation = 0;
+        uint16_t bucket     = 0;    // level * SLOTS + slot it is filed under
+        bool     linked     = false;
+    };
+
+    static uint16_t bucketFor(uint64_t expires, uint64_t now) {
+        uint64_t diff = expires - now;
+        int level = 0;
+        while (level < LEVELS - 1 && diff >= ((uint64_t)1 << (BITS * (level + 1)))) level++;
+        return (uint16_t)(level * SLOTS + ((expires >> (BITS * level)) & MASK));
+    }
+
+    void link(uint32_t index) {
+        nodes[index].bucket = bucketFor(nodes[index].expires, current);
+        uint32_t &head = heads[nodes[index].bucket / SLOTS][nodes[index].bucket % SLOTS];
+        nodes[index].prev = NIL;
+        nodes[index].next = head;
+        if (head != NIL) nodes[head].prev = index;
+        head = index;
+    }
+
+    void unlink(uint32_t index) {
+        Node &n = nodes[index];
+        if (n.prev != NIL) nodes[n.prev].next = n.next;
+        else heads[n.bucket / SLOTS][n.bucket % SLOTS] = n.next;
+        if (n.next != NIL) nodes[n.next].prev = n.prev;
+        n.linked = false;
+    }
+
+    void release(uint32_t index) {
+        nodes[index].generation++;
+        nodes[index].next = freeNodes;
+        freeNodes = index;
+    }
+
+    // Re-files every timer of one higher-level slot relative to now
+    void cascade(int level, uint64_t slot) {
+        uint32_t index = heads[level][slot];
+        heads[level][slot] = NIL;
+        while (index != NIL) {
+            uint32_t next = nodes[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    uint32_t heads[LEVELS][SLOTS];
+    std::vector<Node> nodes;
+    uint32_t freeNodes;
+    uint64_t current;
+};
+
+#endif